@@ -0,0 +1,166 @@
+#include "./quadricSolver.h"
+
+static const size_t BENCH_SIZE    = 1 << 16;  //> equasions per pass, fits in L2 with results
+static const size_t BENCH_PASSES  = 512;      //> passes over the same arrays
+static const size_t BENCH_REPEATS = 15;       //> best of BENCH_REPEATS runs is reported
+
+static const size_t ALLOC_BENCH_SIZE    = 1 << 22;  //> equasions in allocator benchmark, far larger than caches and 4K TLB reach
+static const size_t ALLOC_BENCH_REPEATS = 5;        //> best of ALLOC_BENCH_REPEATS passes is reported
+
+/**
+ * @fn static double benchSeconds()
+ * @brief returns monotonic time in seconds
+ */
+static double benchSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @struct AllocBench
+ * @brief one run of allocator benchmark, filled by the worker thread
+ */
+struct AllocBench
+{
+    int flags;          /** BatchAllocFlags to allocate with */
+    int source;         /** BatchBufferSource actually used */
+    bool pinned;        /** whether the worker was pinned to NUMA node 0 */
+    double setup;       /** seconds to allocate and fill the arrays */
+    double solve;       /** best seconds of one pass of quadricSolverBatch */
+    double checksum;    /** sum of some roots, so that the work is not optimized out */
+};
+
+/**
+ * @fn static void allocBenchRun(struct AllocBench *run)
+ * @brief allocates, fills and solves ALLOC_BENCH_SIZE equasions the way batch jobs do, on the calling thread
+ * @param run pointer to benchmark run struct with flags set
+ */
+static void allocBenchRun(struct AllocBench *run)
+{
+    run->pinned = (run->flags & BATCH_ALLOC_NUMA) && numaPinThread(0);
+
+    size_t stride = ALLOC_BENCH_SIZE * sizeof(double);
+    double start = benchSeconds();
+    struct BatchBuffer buf = {};
+    if (!BatchBuffer_construct(&buf, 6 * (stride + BATCH_STAGGER), run->flags)) {
+        run->source = -1;
+        return;
+    }
+    run->source = buf.source;
+
+    double *a        = (double *)BatchBuffer_array(&buf, 0, stride);
+    double *b        = (double *)BatchBuffer_array(&buf, 1, stride);
+    double *c        = (double *)BatchBuffer_array(&buf, 2, stride);
+    double *result_1 = (double *)BatchBuffer_array(&buf, 3, stride);
+    double *result_2 = (double *)BatchBuffer_array(&buf, 4, stride);
+    bool *result_eq_inf = (bool *)BatchBuffer_array(&buf, 5, stride);
+
+    unsigned seed = 42;
+    for (size_t i = 0; i < ALLOC_BENCH_SIZE; ++i) {
+        a[i] = (double)rand_r(&seed) / RAND_MAX * 10 - 5;
+        b[i] = (double)rand_r(&seed) / RAND_MAX * 10 - 5;
+        c[i] = (double)rand_r(&seed) / RAND_MAX * 10 - 5;
+    }
+    run->setup = benchSeconds() - start;
+
+    run->solve = INFINITY;
+    run->checksum = 0;
+    for (size_t r = 0; r < ALLOC_BENCH_REPEATS; ++r) {
+        start = benchSeconds();
+        quadricSolverBatch(a, b, c, result_1, result_2, result_eq_inf, ALLOC_BENCH_SIZE);
+        double elapsed = benchSeconds() - start;
+        if (elapsed < run->solve)
+            run->solve = elapsed;
+        if (isfinite(result_1[r]))
+            run->checksum += result_1[r];
+    }
+
+    BatchBuffer_destruct(&buf);
+}
+
+/**
+ * @fn static void allocBench()
+ * @brief compares default, huge page and NUMA pinned allocation of batch arrays
+ * Every variant runs in its own thread, so first touch and pinning happen the way they do in jobs.
+ */
+static void allocBench()
+{
+    const char *names[] = {"default", "huge", "huge+numa"};
+    int flags[] = {BATCH_ALLOC_DEFAULT, BATCH_ALLOC_HUGE, BATCH_ALLOC_HUGE | BATCH_ALLOC_NUMA};
+
+    printf("\nallocator, %zu eqs (%zu MB)\n", ALLOC_BENCH_SIZE, 6 * ALLOC_BENCH_SIZE * sizeof(double) >> 20);
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i) {
+        struct AllocBench run = {};
+        run.flags = flags[i];
+        std::thread worker(allocBenchRun, &run);
+        worker.join();
+
+        if (run.source < 0) {
+            printf("%-10s failed to allocate\n", names[i]);
+            continue;
+        }
+        printf("%-10s %-8s%s setup %8.3f ms  solve %8.3f ns/eq  checksum %lg\n", names[i],
+               BATCH_BUF_SOURCE_NAMES[run.source], (run.pinned ? " pinned" : "       "),
+               run.setup * 1e3, run.solve / (double)ALLOC_BENCH_SIZE * 1e9, run.checksum);
+    }
+}
+
+int main()
+{
+    double *a        = (double *)calloc(BENCH_SIZE, sizeof(double));
+    double *b        = (double *)calloc(BENCH_SIZE, sizeof(double));
+    double *c        = (double *)calloc(BENCH_SIZE, sizeof(double));
+    double *result_1 = (double *)calloc(BENCH_SIZE, sizeof(double));
+    double *result_2 = (double *)calloc(BENCH_SIZE, sizeof(double));
+    double *result_im = (double *)calloc(BENCH_SIZE, sizeof(double));
+    bool *result_eq_inf = (bool *)calloc(BENCH_SIZE, sizeof(bool));
+
+    if (!a || !b || !c || !result_1 || !result_2 || !result_im || !result_eq_inf) {
+        fprintf(stderr, "Failed to allocate benchmark arrays\n");
+        return 1;
+    }
+
+    srand(42);
+    for (size_t i = 0; i < BENCH_SIZE; ++i) {           // about half of equasions have complex roots
+        a[i] = (double)rand() / RAND_MAX * 10 - 5;
+        b[i] = (double)rand() / RAND_MAX * 10 - 5;
+        c[i] = (double)rand() / RAND_MAX * 10 - 5;
+    }
+
+    double bestReal = INFINITY, bestComplex = INFINITY;
+    double checksum = 0;
+    for (size_t r = 0; r < BENCH_REPEATS; ++r) {
+        double start = benchSeconds();
+        for (size_t p = 0; p < BENCH_PASSES; ++p)
+            quadricSolverBatch(a, b, c, result_1, result_2, result_eq_inf, BENCH_SIZE);
+        double elapsed = benchSeconds() - start;
+        if (isfinite(result_2[r]))                      // no real roots give NAN
+            checksum += result_2[r];
+        if (elapsed < bestReal)
+            bestReal = elapsed;
+
+        start = benchSeconds();
+        for (size_t p = 0; p < BENCH_PASSES; ++p)
+            quadricSolverBatchComplex(a, b, c, result_1, result_2, result_im, result_eq_inf, BENCH_SIZE);
+        elapsed = benchSeconds() - start;
+        if (isfinite(result_2[r]))
+            checksum += result_2[r] + result_im[r];
+        if (elapsed < bestComplex)
+            bestComplex = elapsed;
+    }
+
+    double eqs = (double)(BENCH_SIZE * BENCH_PASSES);
+    printf("quadricSolverBatch        %8.3f ns/eq\n", bestReal    / eqs * 1e9);
+    printf("quadricSolverBatchComplex %8.3f ns/eq  (%+.1f%%)\n", bestComplex / eqs * 1e9, (bestComplex / bestReal - 1) * 100);
+    printf("checksum %lg\n", checksum);
+
+    free(a);
+    free(b);
+    free(c);
+    free(result_1);
+    free(result_2);
+    free(result_im);
+    free(result_eq_inf);
+
+    allocBench();
+}
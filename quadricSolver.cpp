@@ -7,13 +7,23 @@ int main()
     cbreak();
     noecho();
 
-    WINDOW* logWin = createWin(LINES - 5, COLS / 2, 0, 0);
-    wborder(logWin, ' ', ' ', ' ',' ',' ',' ',' ',' ');
+    struct LogPad log = {};
+    LogPad_construct(&log, LINES - INPUT_WIN_HEIGHT, COLS / 2);
+    WINDOW *logWin = log.pad;
 
     wprintw(logWin, "==============================\n");
     wprintw(logWin, "== QuadricSolver by Lord-KA ==\n");
     wprintw(logWin, "==============================\n");
-    wrefresh(logWin);
+
+    WINDOW *sideWin  = createWin(LINES - INPUT_WIN_HEIGHT, COLS / 2 + 1, 0, COLS / 2);
+    WINDOW *plotWin  = createWin(LINES - 15, COLS / 2 - 8, 5, COLS / 2 + 5);
+	wborder(plotWin, ' ', ' ', ' ',' ',' ',' ',' ',' ');
+    wnoutrefresh(plotWin);
+    WINDOW *jobsWin  = newwin(MAX_JOBS, COLS / 2 - 2, 1, COLS / 2 + 1);
+    WINDOW *inputWin = createWin(INPUT_WIN_HEIGHT, COLS, LINES - INPUT_WIN_HEIGHT, 0);
+
+    struct JobTable jobs;
+    JobTable_construct(&jobs, jobsWin);
 
     char keyword[MAX_CMD_LENGHT + 1] = "";
     char input  [MAX_CMD_LENGHT + 1] = "";
@@ -21,15 +31,18 @@ int main()
     struct History *h = (History*)calloc(1, sizeof(struct History));
     History_construct(h, logWin);
 
-    WINDOW *inputWin;
     while (true) { 
-        inputWin = createWin(5, COLS, LINES - 5, 0);
-
+        mvwhline(inputWin, 2, 1, ' ', COLS - 2);
         mvwprintw(inputWin, 2, 2, ">>> ");
-        wrefresh(inputWin);
+        wnoutrefresh(inputWin);
+
+        JobTable_poll(&jobs, &log);
+        LogPad_stage(&log);
+        doupdate();                                 // the only terminal flush per command
 
-        mvwreadline(inputWin, h, 2, 6, input, MAX_CMD_LENGHT);
+        mvwreadline(inputWin, h, &log, &jobs, 2, 6, input, MAX_CMD_LENGHT);
 
+        log.scrollBack = 0;
         wprintw(logWin, ">>> %s\n", input);
         
         sscanf(input, "%s", keyword);
@@ -46,7 +59,7 @@ int main()
             break;                                  
 
         else if (strcmp(keyword, "clear") == 0) 
-            wclear(logWin);             
+            werase(logWin);             
         
         else if (strcmp(keyword, "plot") == 0) {
             double a = 0, b = 0, c = 0;
@@ -54,7 +67,7 @@ int main()
                 wprintw(logWin, "Bad input. Type 'help' for additional info.\n");
             }
             else {
-                printGraph(a, b, c);
+                printGraph(plotWin, a, b, c);
             }
         }
             
@@ -67,34 +80,107 @@ int main()
             else {
                 double result_1 = NAN;
                 double result_2 = NAN;
+                double result_im = 0;
                 bool result_eq_inf = false;
            
-                quadricSolver(a, b, c, &result_1, &result_2, &result_eq_inf);
+                quadricSolverComplex(a, b, c, &result_1, &result_2, &result_im, &result_eq_inf);
 
                 wprintw(logWin, "%.2f x^2 + %.2f x + %.2f = 0  <=>  x \\in ", a, b, c);
                 if (result_eq_inf)
                     wprintw(logWin, "\\R \n");
                 else if (isnan(result_1))
                     wprintw(logWin, "\\emptyset\n");
+                else if (result_im > 0)
+                    wprintw(logWin, "{ %lf - %lf i, %lf + %lf i }\n", result_1, result_im, result_2, result_im);
                 else if(isnan(result_2) || fabs(result_1 - result_2) < TOL)
                     wprintw(logWin, "{ %lf }\n", result_1);
                 else 
                     wprintw(logWin, "{ %lf, %lf }\n", result_1, result_2);
             }
         }
+
+        else if (strcmp(keyword, "solve-file") == 0) {
+            struct Job *job = JobTable_alloc(&jobs, input);
+            if (!job) {
+                wprintw(logWin, "Too many jobs. Type 'jobs' to list them.\n");
+            }
+            else if (sscanf(input, "%s %s %s", keyword, job->inPath, job->outPath) != 3) {
+                wprintw(logWin, "Bad input. Type 'help' for additional info.\n");
+            }
+            else {
+                job->kind = JOB_SOLVE_FILE;
+                JobTable_start(&jobs, job);
+            }
+        }
+
+        else if (strcmp(keyword, "sweep") == 0) {
+            struct Job *job = JobTable_alloc(&jobs, input);
+            double a = 0, b = 0, c_from = 0, c_to = 0;
+            long long n = 0;
+            if (!job) {
+                wprintw(logWin, "Too many jobs. Type 'jobs' to list them.\n");
+            }
+            else if (sscanf(input, "%s %lf %lf %lf %lf %lld", keyword, &a, &b, &c_from, &c_to, &n) != 6 || n <= 0 || !doubleValidate(4,  a, b, c_from, c_to)) {
+                wprintw(logWin, "Bad input. Type 'help' for additional info.\n");
+            }
+            else {
+                job->kind = JOB_SWEEP;
+                job->a = a;
+                job->b = b;
+                job->c_from = c_from;
+                job->c_to = c_to;
+                job->total = (size_t)n;
+                JobTable_start(&jobs, job);
+            }
+        }
+
+        else if (strcmp(keyword, "jobs") == 0)
+            JobTable_list(&jobs, logWin);
+
+        else if (strcmp(keyword, "alloc") == 0) {
+            char mode[MAX_CMD_LENGHT + 1] = "";
+            int node = 0;
+            int fields = sscanf(input, "%s %s %d", keyword, mode, &node);
+            if (fields >= 2 && strcmp(mode, "default") == 0)
+                jobs.allocFlags = BATCH_ALLOC_DEFAULT;
+            else if (fields >= 2 && strcmp(mode, "huge") == 0)
+                jobs.allocFlags = BATCH_ALLOC_HUGE;
+            else if (fields == 3 && strcmp(mode, "numa") == 0 && node >= 0) {
+                jobs.allocFlags = BATCH_ALLOC_HUGE | BATCH_ALLOC_NUMA;
+                jobs.numaNode = node;
+            }
+            else if (fields >= 2)
+                wprintw(logWin, "Bad input. Type 'help' for additional info.\n");
+
+            wprintw(logWin, "New jobs allocate %s", (jobs.allocFlags & BATCH_ALLOC_HUGE ? "huge pages" : "by default"));
+            if (jobs.allocFlags & BATCH_ALLOC_NUMA)
+                wprintw(logWin, " pinned to NUMA node %d", jobs.numaNode);
+            wprintw(logWin, ".\n");
+        }
+
+        else if (strcmp(keyword, "cancel") == 0) {
+            size_t id = 0;
+            if (sscanf(input, "%s %zu", keyword, &id) != 2 || !JobTable_cancel(&jobs, id)) {
+                wprintw(logWin, "No such running job. Type 'jobs' to list them.\n");
+            }
+        }
         else {
             wprintw(logWin, "Bad input. Type 'help' for additional info.\n");
         }
-        
-        destroyWin(inputWin);
-        wrefresh(logWin);
+
         History_put(h, input);
     }
     History_list(h);
     History_destruct(h);
     free(h);
 
-    destroyWin(logWin);
+    JobTable_destruct(&jobs);
+
+    destroyWin(inputWin);
+    delwin(jobsWin);
+    destroyWin(plotWin);
+    destroyWin(sideWin);
+    LogPad_destruct(&log);
 
     endwin();
 }
@@ -13,19 +13,22 @@
 #include <math.h>
 #include <ctype.h>
 #include <assert.h>
+#include <stdint.h>
 
 #include <ncurses.h>
 
-/**
- * @fn double sign(double x)
- * @brief return sign of double x
- * @param x a double number
- */
-double sign(double x) { 
-    if (x < 0) return -1; 
-    if (x > 0) return 1; 
-    else return 0;
-}
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sched.h>
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)     //> 2 MB page size for MAP_HUGETLB, only <linux/mman.h> defines it
+#endif
+#endif
 
 static const double TOL = 1e-3;     //> Tolerance for double calculations
 static const double GRAPH_TOL = 1;  //> Tolerance for printing the graph
@@ -35,6 +38,22 @@ static const void* POINTER_POISON = (void*)0xDEADBEEF;
 static const size_t HISTORY_LENGHT = 64;  //> the max number of entries in history           //TODO add Makefile; add `make install` option; add history save support
 static const size_t MAX_CMD_LENGHT = 64;  //> the max len of an entry
 
+static const int LOG_PAD_LINES = 512;     //> the number of lines kept in log pad, older ones are scrolled out
+static const int INPUT_WIN_HEIGHT = 5;    //> height of the input window at the bottom of the screen
+
+static const size_t MAX_JOBS       = 4;      //> the max number of simultaneous jobs, one progress bar line each
+static const size_t JOB_CHUNK_SIZE = 4096;   //> equasions solved between cancellation checks
+static const int    JOB_POLL_MS    = 100;    //> progress redraw period while waiting for input
+
+static const size_t PIPE_CHUNK_BYTES = 1 << 16;                   //> bytes of input text per pipeline chunk
+static const size_t PIPE_CHUNK_EQS   = PIPE_CHUNK_BYTES / 6 + 1;  //> max equasions per chunk, the shortest line is "0 0 0\n"
+static const size_t PIPE_CHUNKS      = 8;                         //> chunks in flight, also capacity of pipeline queues
+static const int    PIPE_SPIN_YIELDS = 64;                        //> yields of a starved stage before it starts sleeping
+static const int    PIPE_SLEEP_MAX_US = 250;                      //> longest sleep of a starved stage, doubles up to it
+
+static const size_t HUGE_PAGE_SIZE = 2 << 20;   //> size of x86-64 huge page, batch buffers are rounded up to it
+static const size_t BATCH_STAGGER  = 7 * 64;    //> gap between arrays of a batch buffer, so that they do not share cache sets
+
 
 #define ALT_BACKSPACE 127       //> macro for backspace entry recognition by NCurses
 
@@ -169,13 +188,121 @@ static void History_list(struct History *history)
  * @}       // end of History_struct group
  */
 
+//==========================================
+// Scrollable log pad
+
+/**
+ * @struct LogPad
+ * @defgroup LogPad_struct
+ * @brief bounded scrollable log shown in the left part of the screen
+ * @addtogroup LogPad_struct
+ * @{
+ */
+struct LogPad
+{
+    /**
+     * @brief pointer to NCurses pad with LOG_PAD_LINES lines of backing buffer
+     */
+    WINDOW *pad; /** pointer to NCurses pad with LOG_PAD_LINES lines of backing buffer */
+
+
+    /**
+     * @brief height of the visible part of the pad
+     */
+    int viewHeight; /** height of the visible part of the pad */
+
+
+    /**
+     * @brief width of the visible part of the pad
+     */
+    int viewWidth; /** width of the visible part of the pad */
+
+
+    /**
+     * @brief number of lines the view is scrolled back from the newest line
+     */
+    int scrollBack; /** number of lines the view is scrolled back from the newest line */
+};
+
+/**
+ * @fn static void LogPad_construct(struct LogPad *log, int viewHeight, int viewWidth)
+ * @brief creates new log pad
+ * Creates new log pad, when it is full the oldest lines are scrolled out
+ * @param log pointer to log pad struct to write results in
+ * @param viewHeight height of the visible part of the pad
+ * @param viewWidth width of the visible part of the pad
+ */
+static void LogPad_construct(struct LogPad *log, int viewHeight, int viewWidth)
+{
+    assert(log);
+
+    log->pad = newpad(LOG_PAD_LINES, viewWidth);
+    assert(log->pad);
+
+    scrollok(log->pad, TRUE);
+    log->viewHeight = viewHeight;
+    log->viewWidth  = viewWidth;
+    log->scrollBack = 0;
+}
+
+/**
+ * @fn static void LogPad_destruct(struct LogPad *log)
+ * @brief destroys log pad struct
+ * @param log pointer to log pad struct to destroy
+ */
+static void LogPad_destruct(struct LogPad *log)
+{
+    assert(log);
+    delwin(log->pad);
+    log->pad = (WINDOW *)POINTER_POISON;
+}
+
+/**
+ * @fn static void LogPad_stage(struct LogPad *log)
+ * @brief stages visible part of the log for the next doupdate()
+ * Copies visible part of the pad to the virtual screen without touching the terminal
+ * @param log pointer to log pad struct
+ */
+static void LogPad_stage(struct LogPad *log)
+{
+    assert(log);
+
+    int top = getcury(log->pad) + 1 - log->viewHeight;
+    if (log->scrollBack > top)
+        log->scrollBack = (top > 0 ? top : 0);
+    top -= log->scrollBack;
+    if (top < 0)
+        top = 0;
+
+    pnoutrefresh(log->pad, top, 0, 0, 0, log->viewHeight - 1, log->viewWidth - 1);
+}
+
+/**
+ * @fn static void LogPad_scroll(struct LogPad *log, int lines)
+ * @brief scrolls the view of the log
+ * @param log pointer to log pad struct
+ * @param lines number of lines to scroll back (positive) or forward (negative)
+ */
+static void LogPad_scroll(struct LogPad *log, int lines)
+{
+    assert(log);
+
+    log->scrollBack += lines;
+    if (log->scrollBack < 0)
+        log->scrollBack = 0;
+    LogPad_stage(log);
+}
+/**
+ * @}       // end of LogPad_struct group
+ */
+
 //==========================================
 // WINDOW management
 
 /**
  * @fn static WINDOW* createWin(int height, int width, int starty, int startx)
  * @brief creates new window
- * Creates new NCurses window with specified parameters
+ * Creates new NCurses window with specified parameters, the box is staged for the next doupdate()
  * @param height height of the window
  * @param width  width of the window
  * @param starty y coordinate of starting of the window
@@ -194,7 +321,7 @@ static WINDOW *createWin(int height, int width, int starty, int startx)
 	box(localWin, 0 , 0);		/* 0, 0 gives default characters 
 					             * for the vertical and horizontal
             					 * lines			                */
-	wrefresh(localWin);		    
+	wnoutrefresh(localWin);		/* staged, flushed by next doupdate() */
 
 	return localWin;
 }
@@ -202,7 +329,7 @@ static WINDOW *createWin(int height, int width, int starty, int startx)
 /**
  * @fn static void destroyWin(WINDOW *localWin)
  * @brief destroys a window
- * Destroys an NCurses window and clears its insides
+ * Destroys an NCurses window and clears its insides, changes are staged for the next doupdate()
  */
 static void destroyWin(WINDOW *localWin)
 {	
@@ -219,33 +346,44 @@ static void destroyWin(WINDOW *localWin)
 	 * 8. bl: character to be used for the bottom left corner of the window 
 	 * 9. br: character to be used for the bottom right corner of the window
 	 */
-	wclear(localWin);
-    wrefresh(localWin);
+	werase(localWin);
+    wnoutrefresh(localWin);
 	delwin(localWin);
 
     localWin = (WINDOW *)POINTER_POISON;
 }
 
+struct JobTable;
+static void JobTable_poll(struct JobTable *table, struct LogPad *log);
+
 /**     
- * @fn static void mvwreadline(WINDOW *localWin, History *history, size_t starty, size_t startx, char *buffer, size_t buflen) 
+ * @fn static void mvwreadline(WINDOW *localWin, History *history, LogPad *log, JobTable *jobs, size_t starty, size_t startx, char *buffer, size_t buflen) 
  * @brief smart readline function with keybind support
- * Smart readline function with KEY_*, BACKSPACE, ENTER etc support
+ * Smart readline function with KEY_*, BACKSPACE, ENTER etc support,
+ * KEY_PPAGE/KEY_NPAGE scroll the log pad.
+ * While waiting for input polls background jobs every JOB_POLL_MS milliseconds.
  * Read up to buflen characters into `buffer`.
  * A terminating '\0' character is added after the input.
  * @param localWin pointer to NCurses WINDOW to read from
  * @param history pointer to history struct
+ * @param log pointer to log pad struct to scroll, may be NULL
+ * @param jobs pointer to job table struct to poll, may be NULL, requires log
  * @param starty y coordinate to read from
  * @param startx x coordinate to read from
  * @param buffer pointer to store input
  * @param buflen size of the buffer
  */
-static void mvwreadline(WINDOW *localWin, History *history, size_t starty, size_t startx, char *buffer, size_t buflen)
+static void mvwreadline(WINDOW *localWin, History *history, LogPad *log, JobTable *jobs, size_t starty, size_t startx, char *buffer, size_t buflen)
 {                                                                                                                             //TODO fix bug with old commands staying on cmd line
     assert(localWin);
     assert(history);
     assert(buffer);
 
+    assert(!jobs || log);
+
     keypad(localWin, TRUE);
+    if (jobs)
+        wtimeout(localWin, JOB_POLL_MS);
     ++buflen;       
     size_t old_curs = curs_set(1);
     size_t pos = 0;
@@ -265,6 +403,10 @@ static void mvwreadline(WINDOW *localWin, History *history, size_t starty, size_
         if (c == KEY_ENTER || c == '\n' || c == '\r') {
             break;
         } 
+        else if (c == ERR && jobs) {
+            JobTable_poll(jobs, log);
+            doupdate();
+        }
         else if (isprint(c)) {
             if (pos < buflen - 1) {
                 memmove(buffer + pos + 1, buffer + pos, len - pos);
@@ -314,6 +456,12 @@ static void mvwreadline(WINDOW *localWin, History *history, size_t starty, size_
                 --historyPos;
             }
         }
+        else if (c == KEY_PPAGE && log) {
+            LogPad_scroll(log, log->viewHeight / 2);
+        }
+        else if (c == KEY_NPAGE && log) {
+            LogPad_scroll(log, -log->viewHeight / 2);
+        }
         else if (c == KEY_RIGHT) {
             if (pos < len)
                 pos += 1;
@@ -342,6 +490,8 @@ static void mvwreadline(WINDOW *localWin, History *history, size_t starty, size_
 
     }
     buffer[len] = '\0';
+    if (jobs)
+        wtimeout(localWin, -1);
     if (old_curs != ERR)            //TODO
         curs_set(old_curs);
 }
@@ -375,19 +525,21 @@ bool doubleValidate(size_t num, ...)            //TODO ask DED if it is reasonab
 }
 
 /**
- * @fn void printGraph(double a, double b, double c)
+ * @fn void printGraph(WINDOW *plotWin, double a, double b, double c)
  * @brief prints parabola y == a * x^2 + b * x + c
- * Creates NCurses windows and prints parabola y == a * x^2 + b * x + c there.
+ * Redraws persistent plotWin with parabola y == a * x^2 + b * x + c,
+ * changes are staged for the next doupdate().
  * Uses GRAPH_EPS when compares doubles
+ * @param plotWin pointer to NCurses WINDOW to draw the plot in
  * @param a coefficient at x^2
  * @param b coefficient at x
  * @param c intercept
  */
-void printGraph(double a, double b, double c)
+void printGraph(WINDOW *plotWin, double a, double b, double c)
 {
-    WINDOW* sideWin = createWin(LINES - 5, COLS / 2 + 1,  0, COLS / 2);
-    WINDOW* plotWin = createWin(LINES - 15, COLS / 2 - 8, 5, COLS / 2 + 5);
-	wborder(plotWin, ' ', ' ', ' ',' ',' ',' ',' ',' ');
+    assert(plotWin);
+
+    werase(plotWin);
 
     double dimentionsDiff = 2.3;
     long long windowHight = LINES - 15;
@@ -431,52 +583,1501 @@ void printGraph(double a, double b, double c)
         }
     }
 
-    wrefresh(plotWin);
-    delwin(plotWin);
-    delwin(sideWin);
-
-    plotWin = (WINDOW *)POINTER_POISON;
-    sideWin = (WINDOW *)POINTER_POISON;
+    wnoutrefresh(plotWin);
 }
 
 /**
- * @fn void quadricSolver(double a, double b, double c, double *result_1, double *result_2, bool *result_eq_inf)
- * @brief solves quadric equasion
- * Solves quadric equasion and puts results in pointers
+ * @fn static inline bool quadricSolverReal(double a, double b, double c, double *result_1, double *result_2, bool *result_eq_inf, double *det)
+ * @brief solves quadric equasion if it has no complex roots, shared by quadricSolver and quadricSolverComplex
  * @param a coefficient at x^2
  * @param b coefficient at x
  * @param c intercept
  * @param result_1 pointer to result value one, before execution *result_1 == NAN
  * @param result_2 pointer to result value two, before execution *result_2 == NAN
  * @param result_eq_inf pointer to flag which states if there is inf num of solutions
+ * @param det pointer to discriminant, written if the roots are complex
+ * @return false if the roots are complex and nothing is written to results, true otherwise
  */
-void quadricSolver(double a, double b, double c, double *result_1, double *result_2, bool *result_eq_inf)
+static inline bool quadricSolverReal(double a, double b, double c, double *result_1, double *result_2, bool *result_eq_inf, double *det)
 {
     if (fabs(a) < TOL) {
         if (fabs(b) < TOL) {
             if (fabs(c) < TOL)
-                *result_eq_inf = true;              
-            else
-                return;
+                *result_eq_inf = true;
         }
         else {
             *result_1 = -c / b;
             *result_2 = *result_1;
         }
+        return true;
     }
 
-   else {                                                       // Quadric case
-        double det = b * b - 4 * a * c;
-        if (fabs(det) < TOL) {
-            *result_1 = -0.5 * b / a;
-            *result_2 = *result_1;
+    *det = b * b - 4 * a * c;                                   // Quadric case
+    if (fabs(*det) < TOL) {
+        *result_1 = -0.5 * b / a;
+        *result_2 = *result_1;
+    }
+    else if (*det > 0) {
+        double interim = -0.5 * (b + (b < 0 ? -1 : 1) * sqrt(*det));
+        *result_1 = c / interim;
+        *result_2 = interim / a;
+    }
+    else
+        return false;
+    return true;
+}
+
+/**
+ * @fn void quadricSolver(double a, double b, double c, double *result_1, double *result_2, bool *result_eq_inf)
+ * @brief solves quadric equasion
+ * Solves quadric equasion and puts results in pointers
+ * @param a coefficient at x^2
+ * @param b coefficient at x
+ * @param c intercept
+ * @param result_1 pointer to result value one, before execution *result_1 == NAN
+ * @param result_2 pointer to result value two, before execution *result_2 == NAN
+ * @param result_eq_inf pointer to flag which states if there is inf num of solutions
+ */
+void quadricSolver(double a, double b, double c, double *result_1, double *result_2, bool *result_eq_inf)
+{
+    double det = 0;
+    quadricSolverReal(a, b, c, result_1, result_2, result_eq_inf, &det);     // complex roots are left NAN
+}
+
+/**
+ * @fn void quadricSolverComplex(double a, double b, double c, double *result_1, double *result_2, double *result_im, bool *result_eq_inf)
+ * @brief solves quadric equasion with complex roots
+ * Same as quadricSolver, but when det < 0 puts the real part of the roots in *result_1 and *result_2
+ * and the imaginary part in *result_im, so the roots are *result_1 +- i * *result_im.
+ * @param a coefficient at x^2
+ * @param b coefficient at x
+ * @param c intercept
+ * @param result_1 pointer to result value one, before execution *result_1 == NAN
+ * @param result_2 pointer to result value two, before execution *result_2 == NAN
+ * @param result_im pointer to non-negative imaginary part of roots, before execution *result_im == 0
+ * @param result_eq_inf pointer to flag which states if there is inf num of solutions
+ */
+void quadricSolverComplex(double a, double b, double c, double *result_1, double *result_2, double *result_im, bool *result_eq_inf)
+{
+    double det = 0;
+    if (quadricSolverReal(a, b, c, result_1, result_2, result_eq_inf, &det))
+        return;
+
+    double halfInv = 0.5 / a;                                   // Complex conjugate pair
+    *result_1 = -b * halfInv;
+    *result_2 = *result_1;
+    *result_im = sqrt(-det) * fabs(halfInv);
+}
+
+/**
+ * @fn void quadricSolverBatch(const double *a, const double *b, const double *c, double *result_1, double *result_2, bool *result_eq_inf, size_t n)
+ * @brief solves n quadric equasions
+ * Solves n quadric equasions a[i] * x^2 + b[i] * x + c[i] == 0 and puts results in arrays,
+ * results are initialized with NAN and false before solving
+ * @param a array of coefficients at x^2
+ * @param b array of coefficients at x
+ * @param c array of intercepts
+ * @param result_1 array of result values one
+ * @param result_2 array of result values two
+ * @param result_eq_inf array of flags which state if there is inf num of solutions
+ * @param n number of equasions
+ */
+void quadricSolverBatch(const double *a, const double *b, const double *c, double *result_1, double *result_2, bool *result_eq_inf, size_t n)
+{
+    assert(a && b && c);
+    assert(result_1 && result_2 && result_eq_inf);
+
+    for (size_t i = 0; i < n; ++i) {
+        result_1[i] = NAN;
+        result_2[i] = NAN;
+        result_eq_inf[i] = false;
+        quadricSolver(a[i], b[i], c[i], &result_1[i], &result_2[i], &result_eq_inf[i]);
+    }
+}
+
+/**
+ * @fn void quadricSolverBatchComplex(const double *a, const double *b, const double *c, double *result_1, double *result_2, double *result_im, bool *result_eq_inf, size_t n)
+ * @brief solves n quadric equasions with complex roots
+ * Same as quadricSolverBatch, but uses quadricSolverComplex, so for det < 0
+ * the roots are result_1[i] +- i * result_im[i]. For real roots result_im[i] == 0.
+ * @param a array of coefficients at x^2
+ * @param b array of coefficients at x
+ * @param c array of intercepts
+ * @param result_1 array of result values one, real parts of complex roots
+ * @param result_2 array of result values two, real parts of complex roots
+ * @param result_im array of imaginary parts of roots
+ * @param result_eq_inf array of flags which state if there is inf num of solutions
+ * @param n number of equasions
+ */
+void quadricSolverBatchComplex(const double *a, const double *b, const double *c, double *result_1, double *result_2, double *result_im, bool *result_eq_inf, size_t n)
+{
+    assert(a && b && c);
+    assert(result_1 && result_2 && result_im && result_eq_inf);
+
+    for (size_t i = 0; i < n; ++i) {
+        result_1[i] = NAN;
+        result_2[i] = NAN;
+        result_im[i] = 0;
+        result_eq_inf[i] = false;
+        quadricSolverComplex(a[i], b[i], c[i], &result_1[i], &result_2[i], &result_im[i], &result_eq_inf[i]);
+    }
+}
+
+//==========================================
+// Batch buffers
+
+/**
+ * @enum BatchAllocFlags
+ * @brief how batch buffers are allocated, flags can be combined
+ */
+enum BatchAllocFlags
+{
+    BATCH_ALLOC_DEFAULT = 0,    //> plain calloc, pages are touched by whoever writes them first
+    BATCH_ALLOC_HUGE    = 1,    //> 2 MB huge pages, touched by the constructing thread
+    BATCH_ALLOC_NUMA    = 2,    //> worker threads are pinned to the CPUs of one NUMA node
+};
+
+/**
+ * @enum BatchBufferSource
+ * @brief where memory of a batch buffer came from
+ */
+enum BatchBufferSource
+{
+    BATCH_BUF_CALLOC,   //> calloc
+    BATCH_BUF_HUGETLB,  //> mmap with MAP_HUGETLB from reserved 2 MB huge pages
+    BATCH_BUF_THP,      //> 2 MB aligned mmap with madvise(MADV_HUGEPAGE), transparent huge pages
+    BATCH_BUF_PAGES,    //> 2 MB aligned mmap the kernel backed with 4 KB pages despite madvise
+};
+
+static const char *BATCH_BUF_SOURCE_NAMES[] = {"calloc", "hugetlb", "thp", "4k"};
+
+/**
+ * @struct BatchBuffer
+ * @defgroup BatchBuffer_struct
+ * @brief zeroed memory for batch arrays, backed by huge pages if asked and possible
+ * @addtogroup BatchBuffer_struct
+ * @{
+ */
+struct BatchBuffer
+{
+    /**
+     * @brief pointer to the memory
+     */
+    void *data; /** pointer to the memory */
+
+
+    /**
+     * @brief size of the mapping, rounded up to HUGE_PAGE_SIZE for huge pages
+     */
+    size_t size; /** size of the mapping */
+
+
+    /**
+     * @brief BatchBufferSource of the memory
+     */
+    int source; /** BatchBufferSource of the memory */
+};
+
+#ifdef __linux__
+/**
+ * @fn static void* BatchBuffer_mapAligned(size_t size)
+ * @brief maps anonymous memory aligned to HUGE_PAGE_SIZE, so that THP can back all of it
+ * @param size size of the mapping, multiple of HUGE_PAGE_SIZE
+ * @return pointer to the mapping if succeeds, NULL otherwise
+ */
+static void* BatchBuffer_mapAligned(size_t size)
+{
+    size_t mapped = size + HUGE_PAGE_SIZE;
+    char *raw = (char *)mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return NULL;
+
+    char *aligned = (char *)(((uintptr_t)raw + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+    if (aligned != raw)
+        munmap(raw, (size_t)(aligned - raw));
+    if (aligned + size != raw + mapped)
+        munmap(aligned + size, (size_t)(raw + mapped - (aligned + size)));
+    return aligned;
+}
+
+/**
+ * @fn static bool thpAvailable()
+ * @brief checks whether transparent huge pages can be requested with madvise
+ * @return false if the kernel has no THP or it is set to never, true otherwise
+ */
+static bool thpAvailable()
+{
+    FILE *mode = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");   // "always [madvise] never"
+    if (!mode)
+        return false;
+
+    char line[64] = "";
+    bool available = fgets(line, sizeof(line), mode) && !strstr(line, "[never]");
+    fclose(mode);
+    return available;
+}
+
+/**
+ * @fn static size_t BatchBuffer_hugeBytes(const void *data)
+ * @brief returns how many bytes of the mapping containing data are backed by transparent huge pages
+ * Reads AnonHugePages of the mapping from /proc/self/smaps, so call it after the first touch.
+ * @param data pointer into the mapping
+ * @return number of bytes in huge pages, 0 if none or unknown
+ */
+static size_t BatchBuffer_hugeBytes(const void *data)
+{
+    FILE *smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps)
+        return 0;
+
+    char line[256] = "", perms[8] = "";
+    unsigned long from = 0, to = 0;
+    size_t hugeKb = 0;
+    bool inside = false;
+    while (fgets(line, sizeof(line), smaps)) {
+        if (sscanf(line, "%lx-%lx %7s", &from, &to, perms) == 3)          // header of the next mapping
+            inside = (from <= (uintptr_t)data && (uintptr_t)data < to);
+        else if (inside && sscanf(line, "AnonHugePages: %zu kB", &hugeKb) == 1)
+            break;
+    }
+    fclose(smaps);
+    return hugeKb * 1024;
+}
+#endif
+
+/**
+ * @fn static bool BatchBuffer_construct(struct BatchBuffer *buf, size_t size, int flags)
+ * @brief allocates zeroed batch buffer
+ * With BATCH_ALLOC_HUGE tries reserved 2 MB huge pages, then transparent huge pages, then calloc,
+ * and touches every page on the calling thread, so it should be called by the thread that uses the buffer.
+ * If the kernel backs the THP mapping with 4 KB pages anyway, source is BATCH_BUF_PAGES.
+ * @param buf pointer to batch buffer struct to write results in
+ * @param size size of the buffer in bytes
+ * @param flags BatchAllocFlags
+ * @return true if succeeds, false otherwise
+ */
+static bool BatchBuffer_construct(struct BatchBuffer *buf, size_t size, int flags)
+{
+    assert(buf);
+
+    buf->data = NULL;
+    buf->size = size;
+    buf->source = BATCH_BUF_CALLOC;
+
+#ifdef __linux__
+    if (flags & BATCH_ALLOC_HUGE) {
+        size_t rounded = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+        void *data = mmap(NULL, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        if (data != MAP_FAILED) {
+            buf->source = BATCH_BUF_HUGETLB;
+        }
+        else if (thpAvailable() && (data = BatchBuffer_mapAligned(rounded))) {
+            if (madvise(data, rounded, MADV_HUGEPAGE) == 0)
+                buf->source = BATCH_BUF_THP;
+            else
+                munmap(data, rounded);
+        }
+
+        if (buf->source != BATCH_BUF_CALLOC) {
+            buf->data = data;
+            buf->size = rounded;
+            memset(buf->data, 0, rounded);          // first touch on the owning thread
+            if (buf->source == BATCH_BUF_THP && BatchBuffer_hugeBytes(buf->data) == 0)
+                buf->source = BATCH_BUF_PAGES;
+            return true;
         }
-        else if (det > 0) { 
-            double interim = -0.5 * (b + sign(b) * sqrt(det));
-            *result_1 = c / interim;
-            *result_2 = interim / a;
+    }
+#else
+    (void)flags;
+#endif
+
+    buf->data = calloc(size, 1);
+    return buf->data != NULL;
+}
+
+/**
+ * @fn static void BatchBuffer_destruct(struct BatchBuffer *buf)
+ * @brief frees batch buffer
+ * @param buf pointer to batch buffer struct to destroy
+ */
+static void BatchBuffer_destruct(struct BatchBuffer *buf)
+{
+    assert(buf);
+
+#ifdef __linux__
+    if (buf->source != BATCH_BUF_CALLOC)
+        munmap(buf->data, buf->size);
+    else
+#endif
+        free(buf->data);
+
+    buf->data = (void *)POINTER_POISON;
+}
+/**
+ * @fn static void* BatchBuffer_array(struct BatchBuffer *buf, size_t index, size_t stride)
+ * @brief returns array number index of a batch buffer split into arrays of stride bytes
+ * Arrays are BATCH_STAGGER bytes apart: with huge pages equal offsets of power of two arrays
+ * map to the same cache sets, and streaming through them together evicts each other.
+ * The buffer must be at least (index + 1) * (stride + BATCH_STAGGER) bytes.
+ * @param buf pointer to batch buffer struct
+ * @param index number of the array
+ * @param stride size of every array in bytes, multiple of 8
+ * @return pointer to the array
+ */
+static void* BatchBuffer_array(struct BatchBuffer *buf, size_t index, size_t stride)
+{
+    assert(buf);
+    assert((index + 1) * (stride + BATCH_STAGGER) <= buf->size);
+
+    return (char *)buf->data + index * (stride + BATCH_STAGGER);
+}
+/**
+ * @}       // end of BatchBuffer_struct group
+ */
+
+/**
+ * @fn static bool numaPinThread(int node)
+ * @brief pins calling thread to the CPUs of NUMA node, threads it creates later inherit the pinning
+ * Reads CPU list of the node from sysfs, so does not need libnuma.
+ * @param node number of NUMA node
+ * @return true if succeeds, false otherwise
+ */
+static bool numaPinThread(int node)
+{
+#ifdef __linux__
+    char path[64] = "";
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+
+    FILE *list = fopen(path, "r");
+    if (!list)
+        return false;
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    int first = 0, last = 0;
+    while (fscanf(list, "%d", &first) == 1) {            // "0-3,8-11"
+        last = first;
+        int c = fgetc(list);
+        if (c == '-') {
+            if (fscanf(list, "%d", &last) != 1)
+                break;
+            c = fgetc(list);
         }
+        for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu)
+            CPU_SET(cpu, &cpus);
+        if (c != ',')
+            break;
     }
+    fclose(list);
+
+    return CPU_COUNT(&cpus) > 0 && sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+    (void)node;
+    return false;
+#endif
 }
 
+//==========================================
+// Background jobs
+
+/**
+ * @enum JobState
+ * @brief state of a background job slot
+ */
+enum JobState
+{
+    JOB_FREE,       //> slot is not used
+    JOB_RUNNING,    //> worker thread is running
+    JOB_DONE,       //> worker has finished, not reported yet
+    JOB_CANCELLED,  //> worker has stopped on cancel request, not reported yet
+    JOB_FAILED,     //> worker has failed, not reported yet
+};
+
+/**
+ * @enum JobKind
+ * @brief kind of a background job
+ */
+enum JobKind
+{
+    JOB_SOLVE_FILE, //> solves equasions from file and writes roots to another file
+    JOB_SWEEP,      //> solves equasions with c swept over a range and counts roots
+};
+
+/**
+ * @enum PipeStage
+ * @brief stages of the solve-file pipeline
+ */
+enum PipeStage
+{
+    PIPE_READ,      //> reads text chunks cut at line ends
+    PIPE_PARSE,     //> parses "a b c" triples
+    PIPE_SOLVE,     //> solves parsed equasions
+    PIPE_WRITE,     //> writes "x1 x2 inf" lines
+    PIPE_STAGES,    //> number of stages
+};
+
+static const char *PIPE_STAGE_NAMES[PIPE_STAGES] = {"read", "parse", "solve", "write"};
+
+/**
+ * @struct Job
+ * @defgroup Job_struct
+ * @brief batch of equasions solved on a worker thread
+ * Worker never touches NCurses, main thread polls progress counters and reports results.
+ * Cancellation is cooperative: worker checks cancelRequested after every JOB_CHUNK_SIZE equasions
+ * (every PIPE_CHUNK_BYTES of input for JOB_SOLVE_FILE).
+ * @addtogroup Job_struct
+ * @{
+ */
+struct Job
+{
+    /**
+     * @brief worker thread
+     */
+    std::thread worker; /** worker thread */
+
+
+    /**
+     * @brief JobState of the slot
+     */
+    std::atomic<int> state; /** JobState of the slot */
+
+
+    /**
+     * @brief flag set by main thread to stop the worker at the next chunk boundary
+     */
+    std::atomic<bool> cancelRequested; /** flag set by main thread to stop the worker at the next chunk boundary */
+
+
+    /**
+     * @brief units of work done (bytes of input written out for JOB_SOLVE_FILE, equasions for JOB_SWEEP)
+     */
+    std::atomic<size_t> processed; /** units of work done */
+
+
+    /**
+     * @brief total units of work, 0 if unknown (input of JOB_SOLVE_FILE is not seekable)
+     */
+    std::atomic<size_t> total; /** total units of work, 0 if unknown */
+
+
+    /**
+     * @brief number of equasions solved
+     */
+    std::atomic<size_t> solved; /** number of equasions solved */
+
+
+    /**
+     * @brief start time of the job
+     */
+    std::chrono::steady_clock::time_point startTime; /** start time of the job */
+
+
+    /**
+     * @brief finish time of the job, valid when state is not JOB_RUNNING
+     */
+    std::chrono::steady_clock::time_point endTime; /** finish time of the job */
+
+
+    /**
+     * @brief nanoseconds each PipeStage of JOB_SOLVE_FILE spent processing chunks
+     */
+    std::atomic<unsigned long long> stageBusyNs[PIPE_STAGES]; /** nanoseconds each PipeStage spent processing chunks */
+
+
+    /**
+     * @brief kind of the job
+     */
+    JobKind kind; /** kind of the job */
+
+
+    /**
+     * @brief command the job was started with
+     */
+    char cmd[MAX_CMD_LENGHT + 1]; /** command the job was started with */
+
+
+    /**
+     * @brief input file path for JOB_SOLVE_FILE
+     */
+    char inPath[MAX_CMD_LENGHT + 1]; /** input file path for JOB_SOLVE_FILE */
+
+
+    /**
+     * @brief output file path for JOB_SOLVE_FILE
+     */
+    char outPath[MAX_CMD_LENGHT + 1]; /** output file path for JOB_SOLVE_FILE */
+
+
+    /**
+     * @brief coefficients for JOB_SWEEP, c is swept from c_from to c_to
+     */
+    double a, b, c_from, c_to; /** coefficients for JOB_SWEEP */
+
+
+    /**
+     * @brief numbers of swept equasions with no, one, two and inf roots
+     */
+    size_t rootsCount[4]; /** numbers of swept equasions with no, one, two and inf roots */
+
+
+    /**
+     * @brief BatchAllocFlags for buffers of the job
+     */
+    int allocFlags; /** BatchAllocFlags for buffers of the job */
+
+
+    /**
+     * @brief NUMA node the worker is pinned to with BATCH_ALLOC_NUMA
+     */
+    int numaNode; /** NUMA node the worker is pinned to with BATCH_ALLOC_NUMA */
+
+
+    /**
+     * @brief BatchBufferSource the job buffers actually came from, -1 if not allocated yet
+     */
+    std::atomic<int> bufSource; /** BatchBufferSource the job buffers actually came from */
+
+
+    /**
+     * @brief whether the worker was pinned to numaNode
+     */
+    std::atomic<bool> pinned; /** whether the worker was pinned to numaNode */
+};
+
+/**
+ * @}       // end of Job_struct group
+ */
+
+/**
+ * @struct PipeChunk
+ * @defgroup Pipeline_struct
+ * @brief solve-file pipeline: reader, parser, solver and writer threads passing recycled chunks
+ * Every stage pops a chunk from its input queue, processes it and pushes it to the next one,
+ * the writer returns chunks to the reader. All chunks are allocated once before the start,
+ * queues are single-producer single-consumer lock-free rings.
+ * @addtogroup Pipeline_struct
+ * @{
+ */
+struct PipeChunk
+{
+    /**
+     * @brief input text of whole lines, '\0'-terminated
+     */
+    char text[PIPE_CHUNK_BYTES + 1]; /** input text of whole lines, '\0'-terminated */
+
+
+    /**
+     * @brief length of text
+     */
+    size_t textLen; /** length of text */
+
+
+    /**
+     * @brief parsed coefficients at x^2
+     */
+    double a[PIPE_CHUNK_EQS]; /** parsed coefficients at x^2 */
+
+
+    /**
+     * @brief parsed coefficients at x
+     */
+    double b[PIPE_CHUNK_EQS]; /** parsed coefficients at x */
+
+
+    /**
+     * @brief parsed intercepts
+     */
+    double c[PIPE_CHUNK_EQS]; /** parsed intercepts */
+
+
+    /**
+     * @brief result values one
+     */
+    double result_1[PIPE_CHUNK_EQS]; /** result values one */
+
+
+    /**
+     * @brief result values two
+     */
+    double result_2[PIPE_CHUNK_EQS]; /** result values two */
+
+
+    /**
+     * @brief flags which state if there is inf num of solutions
+     */
+    bool result_eq_inf[PIPE_CHUNK_EQS]; /** flags which state if there is inf num of solutions */
+
+
+    /**
+     * @brief number of parsed equasions
+     */
+    size_t n; /** number of parsed equasions */
+
+
+    /**
+     * @brief chunk is the last one of the file
+     */
+    bool last; /** chunk is the last one of the file */
+};
+
+/**
+ * @struct PipeQueue
+ * @brief bounded single-producer single-consumer lock-free queue of chunks
+ */
+struct PipeQueue
+{
+    /**
+     * @brief ring of chunk pointers
+     */
+    PipeChunk *slots[PIPE_CHUNKS]; /** ring of chunk pointers */
+
+
+    /**
+     * @brief number of popped chunks, written by consumer
+     */
+    alignas(64) std::atomic<size_t> head; /** number of popped chunks, written by consumer */
+
+
+    /**
+     * @brief number of pushed chunks, written by producer
+     */
+    alignas(64) std::atomic<size_t> tail; /** number of pushed chunks, written by producer */
+};
+
+/**
+ * @fn static void PipeQueue_construct(struct PipeQueue *queue)
+ * @brief creates empty queue
+ * @param queue pointer to queue struct to write results in
+ */
+static void PipeQueue_construct(struct PipeQueue *queue)
+{
+    assert(queue);
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+/**
+ * @fn static bool PipeQueue_push(struct PipeQueue *queue, struct PipeChunk *chunk)
+ * @brief pushes chunk to queue, must be called by the only producer
+ * @param queue pointer to queue struct
+ * @param chunk pointer to chunk to push
+ * @return true if succeeds, false if queue is full
+ */
+static bool PipeQueue_push(struct PipeQueue *queue, struct PipeChunk *chunk)
+{
+    size_t tail = queue->tail.load(std::memory_order_relaxed);
+    if (tail - queue->head.load(std::memory_order_acquire) == PIPE_CHUNKS)
+        return false;
+
+    queue->slots[tail % PIPE_CHUNKS] = chunk;
+    queue->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @fn static struct PipeChunk* PipeQueue_pop(struct PipeQueue *queue)
+ * @brief pops chunk from queue, must be called by the only consumer
+ * @param queue pointer to queue struct
+ * @return pointer to chunk if succeeds, NULL if queue is empty
+ */
+static struct PipeChunk* PipeQueue_pop(struct PipeQueue *queue)
+{
+    size_t head = queue->head.load(std::memory_order_relaxed);
+    if (head == queue->tail.load(std::memory_order_acquire))
+        return NULL;
+
+    struct PipeChunk *chunk = queue->slots[head % PIPE_CHUNKS];
+    queue->head.store(head + 1, std::memory_order_release);
+    return chunk;
+}
+
+/**
+ * @struct Pipeline
+ * @brief state shared by the pipeline stages of one JOB_SOLVE_FILE
+ */
+struct Pipeline
+{
+    /**
+     * @brief job the pipeline runs for
+     */
+    struct Job *job; /** job the pipeline runs for */
+
+
+    /**
+     * @brief file to read "a b c" lines from
+     */
+    FILE *in; /** file to read "a b c" lines from */
+
+
+    /**
+     * @brief file to write "x1 x2 inf" lines to
+     */
+    FILE *out; /** file to write "x1 x2 inf" lines to */
+
+
+    /**
+     * @brief PIPE_CHUNKS chunks allocated at start
+     */
+    struct PipeChunk *chunks; /** PIPE_CHUNKS chunks allocated at start */
+
+
+    /**
+     * @brief incomplete last line of the previous read
+     */
+    char *carry; /** incomplete last line of the previous read */
+
+
+    /**
+     * @brief length of carry
+     */
+    size_t carryLen; /** length of carry */
+
+
+    /**
+     * @brief chunks passed from writer to reader
+     */
+    struct PipeQueue freeQueue; /** chunks passed from writer to reader */
+
+
+    /**
+     * @brief chunks passed from reader to parser
+     */
+    struct PipeQueue readQueue; /** chunks passed from reader to parser */
+
+
+    /**
+     * @brief chunks passed from parser to solver
+     */
+    struct PipeQueue parsedQueue; /** chunks passed from parser to solver */
+
+
+    /**
+     * @brief chunks passed from solver to writer
+     */
+    struct PipeQueue solvedQueue; /** chunks passed from solver to writer */
+
+
+    /**
+     * @brief set on cancel or failure to stop all stages
+     */
+    std::atomic<bool> stop; /** set on cancel or failure to stop all stages */
+
+
+    /**
+     * @brief set when the input can not be parsed
+     */
+    std::atomic<bool> failed; /** set when the input can not be parsed */
+};
+
+/**
+ * @fn static bool Pipeline_stopped(struct Pipeline *pipe)
+ * @brief checks whether the stages should stop, turning a cancel request into a stop
+ * @param pipe pointer to pipeline struct
+ * @return true if the pipeline is stopped
+ */
+static bool Pipeline_stopped(struct Pipeline *pipe)
+{
+    if (pipe->job->cancelRequested)
+        pipe->stop = true;
+    return pipe->stop;
+}
+
+/**
+ * @fn static struct PipeChunk* Pipeline_pop(struct Pipeline *pipe, struct PipeQueue *queue)
+ * @brief waits for a chunk in queue, yielding PIPE_SPIN_YIELDS times and then sleeping with backoff
+ * A chunk popped after the pipeline is stopped is dropped, so cancel takes effect at the next chunk
+ * of every stage. Dropped chunks stay in the pool and are freed by Pipeline_run.
+ * @param pipe pointer to pipeline struct
+ * @param queue pointer to queue to pop from
+ * @return pointer to chunk if succeeds, NULL if the pipeline is stopped
+ */
+static struct PipeChunk* Pipeline_pop(struct Pipeline *pipe, struct PipeQueue *queue)
+{
+    struct PipeChunk *chunk = NULL;
+    int spins = 0, sleepUs = 1;
+    while (!Pipeline_stopped(pipe) && !(chunk = PipeQueue_pop(queue))) {
+        if (spins < PIPE_SPIN_YIELDS) {
+            ++spins;
+            std::this_thread::yield();
+            continue;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(sleepUs));
+        sleepUs = (2 * sleepUs < PIPE_SLEEP_MAX_US ? 2 * sleepUs : PIPE_SLEEP_MAX_US);
+    }
+
+    if (chunk && Pipeline_stopped(pipe))
+        return NULL;
+    return chunk;
+}
+
+/**
+ * @fn static void Pipeline_countBusy(struct Pipeline *pipe, PipeStage stage, std::chrono::steady_clock::time_point start)
+ * @brief adds time since start to the busy time of the stage
+ * @param pipe pointer to pipeline struct
+ * @param stage stage that has processed a chunk
+ * @param start time the stage popped the chunk
+ */
+static void Pipeline_countBusy(struct Pipeline *pipe, PipeStage stage, std::chrono::steady_clock::time_point start)
+{
+    std::chrono::nanoseconds busy = std::chrono::steady_clock::now() - start;
+    pipe->job->stageBusyNs[stage] += (unsigned long long)busy.count();
+}
+
+/**
+ * @fn static void Pipeline_push(struct PipeQueue *queue, struct PipeChunk *chunk)
+ * @brief pushes chunk to the next stage, never blocks as every queue can hold all the chunks
+ * @param queue pointer to queue to push to
+ * @param chunk pointer to chunk to push
+ */
+static void Pipeline_push(struct PipeQueue *queue, struct PipeChunk *chunk)
+{
+    bool pushed = PipeQueue_push(queue, chunk);
+    assert(pushed);
+    (void)pushed;
+}
+
+/**
+ * @fn static void Pipeline_read(struct Pipeline *pipe)
+ * @brief reader stage, fills chunks with whole lines of input
+ * @param pipe pointer to pipeline struct
+ */
+static void Pipeline_read(struct Pipeline *pipe)
+{
+    struct PipeChunk *chunk = NULL;
+    while ((chunk = Pipeline_pop(pipe, &pipe->freeQueue))) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        memcpy(chunk->text, pipe->carry, pipe->carryLen);
+        size_t want = PIPE_CHUNK_BYTES - pipe->carryLen;
+        size_t got = fread(chunk->text + pipe->carryLen, 1, want, pipe->in);
+        size_t len = pipe->carryLen + got;
+
+        chunk->last = (got < want);
+        chunk->textLen = len;
+        pipe->carryLen = 0;
+        if (!chunk->last) {
+            while (chunk->textLen > 0 && chunk->text[chunk->textLen - 1] != '\n')
+                --chunk->textLen;
+            if (chunk->textLen == 0) {              // line is longer than a chunk
+                pipe->failed = true;
+                pipe->stop = true;
+                break;
+            }
+            pipe->carryLen = len - chunk->textLen;
+            memcpy(pipe->carry, chunk->text + chunk->textLen, pipe->carryLen);
+        }
+        chunk->text[chunk->textLen] = '\0';
+
+        bool last = chunk->last;
+        Pipeline_countBusy(pipe, PIPE_READ, start);
+        Pipeline_push(&pipe->readQueue, chunk);
+        if (last)
+            break;
+    }
+}
+
+/**
+ * @fn static bool Pipeline_parseChunk(struct PipeChunk *chunk)
+ * @brief parses "a b c" triples from chunk text
+ * @param chunk pointer to chunk
+ * @return true if succeeds, false if text is not a sequence of triples
+ */
+static bool Pipeline_parseChunk(struct PipeChunk *chunk)
+{
+    char *pos = chunk->text;
+    size_t n = 0;
+
+    while (true) {
+        while (isspace((unsigned char)*pos))
+            ++pos;
+        if (*pos == '\0')
+            break;
+        if (n == PIPE_CHUNK_EQS)
+            return false;
+
+        double *coefs[] = {&chunk->a[n], &chunk->b[n], &chunk->c[n]};
+        for (size_t i = 0; i < 3; ++i) {
+            char *end = pos;
+            *coefs[i] = strtod(pos, &end);
+            if (end == pos)
+                return false;
+            pos = end;
+        }
+        ++n;
+    }
+
+    chunk->n = n;
+    return true;
+}
+
+/**
+ * @fn static void Pipeline_parse(struct Pipeline *pipe)
+ * @brief parser stage
+ * @param pipe pointer to pipeline struct
+ */
+static void Pipeline_parse(struct Pipeline *pipe)
+{
+    struct PipeChunk *chunk = NULL;
+    while ((chunk = Pipeline_pop(pipe, &pipe->readQueue))) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (!Pipeline_parseChunk(chunk)) {
+            pipe->failed = true;
+            pipe->stop = true;
+            break;
+        }
+
+        bool last = chunk->last;                // chunk belongs to the next stage after push
+        Pipeline_countBusy(pipe, PIPE_PARSE, start);
+        Pipeline_push(&pipe->parsedQueue, chunk);
+        if (last)
+            break;
+    }
+}
+
+/**
+ * @fn static void Pipeline_solve(struct Pipeline *pipe)
+ * @brief solver stage
+ * @param pipe pointer to pipeline struct
+ */
+static void Pipeline_solve(struct Pipeline *pipe)
+{
+    struct PipeChunk *chunk = NULL;
+    while ((chunk = Pipeline_pop(pipe, &pipe->parsedQueue))) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        quadricSolverBatch(chunk->a, chunk->b, chunk->c, chunk->result_1, chunk->result_2, chunk->result_eq_inf, chunk->n);
+        pipe->job->solved += chunk->n;
+
+        bool last = chunk->last;
+        Pipeline_countBusy(pipe, PIPE_SOLVE, start);
+        Pipeline_push(&pipe->solvedQueue, chunk);
+        if (last)
+            break;
+    }
+}
+
+/**
+ * @fn static void Pipeline_write(struct Pipeline *pipe)
+ * @brief writer stage, returns written chunks to the reader
+ * @param pipe pointer to pipeline struct
+ */
+static void Pipeline_write(struct Pipeline *pipe)
+{
+    struct PipeChunk *chunk = NULL;
+    while ((chunk = Pipeline_pop(pipe, &pipe->solvedQueue))) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < chunk->n; ++i) {
+            if (i % JOB_CHUNK_SIZE == 0 && Pipeline_stopped(pipe))     // writing a chunk takes longest
+                return;
+            fprintf(pipe->out, "%lg %lg %d\n", chunk->result_1[i], chunk->result_2[i], chunk->result_eq_inf[i]);
+        }
+
+        pipe->job->processed += chunk->textLen;    // progress is input whose roots are written
+        bool last = chunk->last;
+        Pipeline_countBusy(pipe, PIPE_WRITE, start);
+        Pipeline_push(&pipe->freeQueue, chunk);
+        if (last)
+            break;
+    }
+}
+
+/**
+ * @fn static int Pipeline_run(struct Job *job, FILE *in, FILE *out)
+ * @brief solves equasions from in and writes roots to out with 4 concurrent stages
+ * Reader, parser and writer run on their own threads, solver runs on the calling thread.
+ * @param job pointer to job struct to update progress and stage counters of
+ * @param in file to read "a b c" lines from
+ * @param out file to write "x1 x2 inf" lines to
+ * @return JobState the job has finished with
+ */
+static int Pipeline_run(struct Job *job, FILE *in, FILE *out)
+{
+    struct Pipeline pipe;
+    pipe.job = job;
+    pipe.in  = in;
+    pipe.out = out;
+    struct BatchBuffer chunks = {};
+    bool allocated = BatchBuffer_construct(&chunks, PIPE_CHUNKS * sizeof(struct PipeChunk), job->allocFlags);
+    pipe.chunks = (struct PipeChunk *)chunks.data;
+    pipe.carry  = (char *)calloc(PIPE_CHUNK_BYTES, sizeof(char));
+    pipe.carryLen = 0;
+    pipe.stop = false;
+    pipe.failed = false;
+
+    if (!allocated || !pipe.carry) {
+        BatchBuffer_destruct(&chunks);
+        free(pipe.carry);
+        return JOB_FAILED;
+    }
+    job->bufSource = chunks.source;
+
+    long size = -1;
+    if (fseek(in, 0, SEEK_END) == 0) {              // pipes and FIFOs are not seekable, total stays unknown
+        size = ftell(in);
+        fseek(in, 0, SEEK_SET);
+    }
+    job->total = (size > 0 ? (size_t)size : 0);
+
+    PipeQueue_construct(&pipe.freeQueue);
+    PipeQueue_construct(&pipe.readQueue);
+    PipeQueue_construct(&pipe.parsedQueue);
+    PipeQueue_construct(&pipe.solvedQueue);
+    for (size_t i = 0; i < PIPE_CHUNKS; ++i)
+        Pipeline_push(&pipe.freeQueue, &pipe.chunks[i]);
+
+    std::thread reader(Pipeline_read,  &pipe);
+    std::thread parser(Pipeline_parse, &pipe);
+    std::thread writer(Pipeline_write, &pipe);
+    Pipeline_solve(&pipe);
+    reader.join();
+    parser.join();
+    writer.join();
+
+    BatchBuffer_destruct(&chunks);
+    free(pipe.carry);
+
+    if (job->cancelRequested)
+        return JOB_CANCELLED;
+    if (pipe.failed || ferror(in) || ferror(out))
+        return JOB_FAILED;
+    return JOB_DONE;
+}
+/**
+ * @}       // end of Pipeline_struct group
+ */
+
+/**
+ * @addtogroup Job_struct
+ * @{
+ */
+
+/**
+ * @fn static int Job_runSolveFile(struct Job *job)
+ * @brief worker of JOB_SOLVE_FILE
+ * Reads "a b c" lines from job->inPath and writes "x1 x2 inf" lines to job->outPath with Pipeline_run
+ * @param job pointer to job struct
+ * @return JobState the job has finished with
+ */
+static int Job_runSolveFile(struct Job *job)
+{
+    FILE *in  = fopen(job->inPath, "r");
+    FILE *out = fopen(job->outPath, "w");
+    int state = JOB_FAILED;
+
+    if (in && out)
+        state = Pipeline_run(job, in, out);
+
+    if (in)
+        fclose(in);
+    if (out && fclose(out) != 0)
+        state = JOB_FAILED;
+    return state;
+}
+
+/**
+ * @fn static int Job_runSweep(struct Job *job)
+ * @brief worker of JOB_SWEEP
+ * Solves job->total equasions a x^2 + b x + c with c evenly swept over [c_from, c_to]
+ * and counts equasions by the number of roots
+ * @param job pointer to job struct
+ * @return JobState the job has finished with
+ */
+static int Job_runSweep(struct Job *job)
+{
+    size_t stride = JOB_CHUNK_SIZE * sizeof(double);
+    struct BatchBuffer buf = {};
+    if (!BatchBuffer_construct(&buf, 6 * (stride + BATCH_STAGGER), job->allocFlags))
+        return JOB_FAILED;
+    job->bufSource = buf.source;
+
+    double *a        = (double *)BatchBuffer_array(&buf, 0, stride);
+    double *b        = (double *)BatchBuffer_array(&buf, 1, stride);
+    double *c        = (double *)BatchBuffer_array(&buf, 2, stride);
+    double *result_1 = (double *)BatchBuffer_array(&buf, 3, stride);
+    double *result_2 = (double *)BatchBuffer_array(&buf, 4, stride);
+    bool   *inf      = (bool   *)BatchBuffer_array(&buf, 5, stride);
+    size_t total = job->total;
+    double step = (total > 1 ? (job->c_to - job->c_from) / (double)(total - 1) : 0);
+
+    for (size_t i = 0; i < JOB_CHUNK_SIZE; ++i) {
+        a[i] = job->a;
+        b[i] = job->b;
+    }
+
+    size_t first = 0;
+    while (!job->cancelRequested && first < total) {
+        size_t n = (total - first < JOB_CHUNK_SIZE ? total - first : JOB_CHUNK_SIZE);
+        for (size_t i = 0; i < n; ++i)
+            c[i] = job->c_from + step * (double)(first + i);
+
+        quadricSolverBatch(a, b, c, result_1, result_2, inf, n);
+        for (size_t i = 0; i < n; ++i) {
+            if (inf[i])
+                ++job->rootsCount[3];
+            else if (isnan(result_1[i]))
+                ++job->rootsCount[0];
+            else if (fabs(result_1[i] - result_2[i]) < TOL)
+                ++job->rootsCount[1];
+            else
+                ++job->rootsCount[2];
+        }
+
+        first += n;
+        job->solved = first;
+        job->processed = first;
+    }
+
+    BatchBuffer_destruct(&buf);
+    return (job->cancelRequested ? JOB_CANCELLED : JOB_DONE);
+}
+
+/**
+ * @fn static void Job_run(struct Job *job)
+ * @brief entry point of the worker thread
+ * @param job pointer to job struct
+ */
+static void Job_run(struct Job *job)
+{
+    assert(job);
+
+    if (job->allocFlags & BATCH_ALLOC_NUMA)            // before stage threads are created, they inherit it
+        job->pinned = numaPinThread(job->numaNode);
+
+    int state = JOB_FAILED;
+    switch (job->kind) {
+        case JOB_SOLVE_FILE:
+            state = Job_runSolveFile(job);
+            break;
+        case JOB_SWEEP:
+            state = Job_runSweep(job);
+            break;
+        default:
+            state = JOB_FAILED;
+    }
+
+    job->endTime = std::chrono::steady_clock::now();
+    job->state = state;
+}
+
+/**
+ * @fn static double Job_elapsed(struct Job *job)
+ * @brief returns seconds since the start of the job till now or till its finish
+ * @param job pointer to job struct
+ */
+static double Job_elapsed(struct Job *job)
+{
+    std::chrono::steady_clock::time_point end = (job->state == JOB_RUNNING ? std::chrono::steady_clock::now() : job->endTime);
+    return std::chrono::duration<double>(end - job->startTime).count();
+}
+
+/**
+ * @fn static double Job_rate(struct Job *job)
+ * @brief returns number of equasions solved per second since the start of the job
+ * @param job pointer to job struct
+ */
+static double Job_rate(struct Job *job)
+{
+    double elapsed = Job_elapsed(job);
+    if (elapsed <= 0)
+        return 0;
+    return (double)job->solved / elapsed;
+}
+
+/**
+ * @fn static void Job_printStages(struct Job *job, WINDOW *logWin)
+ * @brief prints utilization of JOB_SOLVE_FILE pipeline stages, the busiest stage limits throughput
+ * Utilization is the share of job time the stage spent processing chunks, waiting on queues is not counted.
+ * @param job pointer to job struct
+ * @param logWin pointer to NCurses WINDOW to print in
+ */
+static void Job_printStages(struct Job *job, WINDOW *logWin)
+{
+    if (job->kind != JOB_SOLVE_FILE)
+        return;
+
+    double elapsed = Job_elapsed(job);
+    wprintw(logWin, "    busy:");
+    for (size_t i = 0; i < PIPE_STAGES; ++i) {
+        double busy = (elapsed > 0 ? (double)job->stageBusyNs[i] * 1e-9 / elapsed : 0);
+        wprintw(logWin, " %s %.0f%%", PIPE_STAGE_NAMES[i], busy * 100);
+    }
+    wprintw(logWin, "\n");
+}
+
+/**
+ * @fn static void Job_printAlloc(struct Job *job, WINDOW *logWin)
+ * @brief prints where job buffers came from and whether the worker was pinned, if not allocated by default
+ * @param job pointer to job struct
+ * @param logWin pointer to NCurses WINDOW to print in
+ */
+static void Job_printAlloc(struct Job *job, WINDOW *logWin)
+{
+    if (job->allocFlags == BATCH_ALLOC_DEFAULT || job->bufSource < 0)
+        return;
+
+    wprintw(logWin, "    memory: %s", BATCH_BUF_SOURCE_NAMES[job->bufSource]);
+    if (job->allocFlags & BATCH_ALLOC_NUMA)
+        wprintw(logWin, ", %s to node %d", (job->pinned ? "pinned" : "not pinned"), job->numaNode);
+    wprintw(logWin, "\n");
+}
+/**
+ * @}       // end of Job_struct group
+ */
+
+/**
+ * @struct JobTable
+ * @defgroup JobTable_struct
+ * @brief fixed table of background jobs and the window their progress is shown in
+ * @addtogroup JobTable_struct
+ * @{
+ */
+struct JobTable
+{
+    /**
+     * @brief job slots
+     */
+    Job jobs[MAX_JOBS]; /** job slots */
+
+
+    /**
+     * @brief pointer to NCurses WINDOW with progress bars, one line per slot
+     */
+    WINDOW *localWin; /** pointer to NCurses WINDOW with progress bars, one line per slot */
+
+
+    /**
+     * @brief number of progress bars drawn at the last poll
+     */
+    size_t shown; /** number of progress bars drawn at the last poll */
+
+
+    /**
+     * @brief BatchAllocFlags for new jobs
+     */
+    int allocFlags; /** BatchAllocFlags for new jobs */
+
+
+    /**
+     * @brief NUMA node for new jobs with BATCH_ALLOC_NUMA
+     */
+    int numaNode; /** NUMA node for new jobs with BATCH_ALLOC_NUMA */
+};
+
+/**
+ * @fn static void JobTable_construct(struct JobTable *table, WINDOW *jobsWin)
+ * @brief creates new job table with all slots free
+ * @param table pointer to job table struct to write results in
+ * @param jobsWin pointer to NCurses WINDOW with MAX_JOBS lines to draw progress in, may be NULL
+ */
+static void JobTable_construct(struct JobTable *table, WINDOW *jobsWin)
+{
+    assert(table);
+
+    for (size_t i = 0; i < MAX_JOBS; ++i) {
+        table->jobs[i].state = JOB_FREE;
+        table->jobs[i].cancelRequested = false;
+    }
+    table->localWin = jobsWin;
+    table->shown = 0;
+    table->allocFlags = BATCH_ALLOC_DEFAULT;
+    table->numaNode = 0;
+}
+
+/**
+ * @fn static void JobTable_destruct(struct JobTable *table)
+ * @brief cancels all running jobs and waits for their workers
+ * @param table pointer to job table struct to destroy
+ */
+static void JobTable_destruct(struct JobTable *table)
+{
+    assert(table);
+
+    for (size_t i = 0; i < MAX_JOBS; ++i)
+        table->jobs[i].cancelRequested = true;
+
+    for (size_t i = 0; i < MAX_JOBS; ++i) {
+        if (table->jobs[i].worker.joinable())
+            table->jobs[i].worker.join();
+        table->jobs[i].state = JOB_FREE;
+    }
+    table->localWin = (WINDOW *)POINTER_POISON;
+}
+
+/**
+ * @fn static struct Job* JobTable_alloc(struct JobTable *table, const char *cmd)
+ * @brief finds a free slot and prepares it for a new job
+ * @param table pointer to job table struct
+ * @param cmd command the job is started with
+ * @return pointer to job slot if succeeds, NULL if all slots are busy
+ */
+static struct Job* JobTable_alloc(struct JobTable *table, const char *cmd)
+{
+    assert(table);
+    assert(cmd);
+
+    for (size_t i = 0; i < MAX_JOBS; ++i) {
+        struct Job *job = &table->jobs[i];
+        if (job->state != JOB_FREE)
+            continue;
+
+        job->cancelRequested = false;
+        job->processed = 0;
+        job->total = 0;
+        job->solved = 0;
+        for (size_t j = 0; j < PIPE_STAGES; ++j)
+            job->stageBusyNs[j] = 0;
+        memset(job->rootsCount, 0, sizeof(job->rootsCount));
+        job->allocFlags = table->allocFlags;
+        job->numaNode = table->numaNode;
+        job->bufSource = -1;
+        job->pinned = false;
+        strncpy(job->cmd, cmd, MAX_CMD_LENGHT);
+        job->cmd[MAX_CMD_LENGHT] = '\0';
+        return job;
+    }
+    return NULL;
+}
+
+/**
+ * @fn static void JobTable_start(struct JobTable *table, struct Job *job)
+ * @brief starts worker thread of a job prepared with JobTable_alloc
+ * @param table pointer to job table struct
+ * @param job pointer to prepared job slot
+ */
+static void JobTable_start(struct JobTable *table, struct Job *job)
+{
+    assert(table);
+    assert(job);
+
+    job->startTime = std::chrono::steady_clock::now();
+    job->state = JOB_RUNNING;
+    job->worker = std::thread(Job_run, job);
+}
+
+/**
+ * @fn static bool JobTable_cancel(struct JobTable *table, size_t id)
+ * @brief requests cooperative cancellation of a running job
+ * @param table pointer to job table struct
+ * @param id index of the job slot
+ * @return true if the job was running, false otherwise
+ */
+static bool JobTable_cancel(struct JobTable *table, size_t id)
+{
+    assert(table);
+
+    if (id >= MAX_JOBS || table->jobs[id].state != JOB_RUNNING)
+        return false;
+
+    table->jobs[id].cancelRequested = true;
+    return true;
+}
+
+/**
+ * @fn static void JobTable_list(struct JobTable *table, WINDOW *logWin)
+ * @brief lists running jobs in logWin
+ * @param table pointer to job table struct
+ * @param logWin pointer to NCurses WINDOW to list jobs in
+ */
+static void JobTable_list(struct JobTable *table, WINDOW *logWin)
+{
+    assert(table);
+
+    size_t running = 0;
+    for (size_t i = 0; i < MAX_JOBS; ++i) {
+        struct Job *job = &table->jobs[i];
+        if (job->state != JOB_RUNNING)
+            continue;
+
+        wprintw(logWin, "[%zu] %s: %zu eqs, %.3g eq/s\n", i, job->cmd, (size_t)job->solved, Job_rate(job));
+        Job_printStages(job, logWin);
+        ++running;
+    }
+    if (!running)
+        wprintw(logWin, "No running jobs.\n");
+}
+
+/**
+ * @fn static void JobTable_poll(struct JobTable *table, struct LogPad *log)
+ * @brief reports finished jobs and redraws progress bars
+ * Joins finished workers, reports their results to the log and frees their slots,
+ * then redraws progress bars of running jobs. Changes are staged for the next doupdate().
+ * Does not touch the windows if there is nothing to show.
+ * @param table pointer to job table struct
+ * @param log pointer to log pad struct to report finished jobs in
+ */
+static void JobTable_poll(struct JobTable *table, struct LogPad *log)
+{
+    assert(table);
+    assert(log);
+
+    bool reported = false;
+    size_t running = 0;
+    for (size_t i = 0; i < MAX_JOBS; ++i) {
+        struct Job *job = &table->jobs[i];
+        int state = job->state;
+
+        if (state == JOB_RUNNING) {
+            ++running;
+            continue;
+        }
+        if (state == JOB_FREE)
+            continue;
+
+        job->worker.join();
+        if (state == JOB_DONE && job->kind == JOB_SWEEP) {
+            wprintw(log->pad, "[%zu] %s: done, roots none/one/two/inf: %zu/%zu/%zu/%zu\n", i, job->cmd,
+                    job->rootsCount[0], job->rootsCount[1], job->rootsCount[2], job->rootsCount[3]);
+            Job_printAlloc(job, log->pad);
+        }
+        else if (state == JOB_DONE) {
+            wprintw(log->pad, "[%zu] %s: done, %zu eqs, %.3g eq/s\n", i, job->cmd, (size_t)job->solved, Job_rate(job));
+            Job_printStages(job, log->pad);
+            Job_printAlloc(job, log->pad);
+        }
+        else if (state == JOB_CANCELLED)
+            wprintw(log->pad, "[%zu] %s: cancelled after %zu eqs\n", i, job->cmd, (size_t)job->solved);
+        else
+            wprintw(log->pad, "[%zu] %s: failed after %zu eqs\n", i, job->cmd, (size_t)job->solved);
+
+        job->state = JOB_FREE;
+        reported = true;
+    }
+
+    if (reported)
+        LogPad_stage(log);
+
+    if (!table->localWin || (!running && !table->shown))
+        return;
+
+    WINDOW *win = table->localWin;
+    int barWidth = getmaxx(win) - 30;
+    if (barWidth < 10)
+        barWidth = 10;
+
+    werase(win);
+    int line = 0;
+    for (size_t i = 0; i < MAX_JOBS; ++i) {
+        struct Job *job = &table->jobs[i];
+        if (job->state != JOB_RUNNING)
+            continue;
+
+        size_t total = job->total;
+        double done = (total ? (double)job->processed / (double)total : 0);
+        int filled = (int)(done * barWidth);
+
+        mvwprintw(win, line, 0, "[%zu] ", i);
+        for (int j = 0; j < barWidth; ++j)
+            waddch(win, j < filled ? '#' : '.');
+        if (total)
+            wprintw(win, " %3d%% %9.3g eq/s", (int)(done * 100), Job_rate(job));
+        else
+            wprintw(win, "    ?%% %9.3g eq/s", Job_rate(job));
+        ++line;
+    }
+    table->shown = running;
+    wnoutrefresh(win);
+}
+/**
+ * @}       // end of JobTable_struct group
+ */
+
 #endif
@@ -3,6 +3,76 @@
 #include "gtest/gtest.h"
 
 static const double TEST_TOL = 1e-2;
+static const int    JOB_TIMEOUT_S = 30;   //> a job running longer than this is considered hung
+
+/**
+ * @fn static Job* startSweep(JobTable *jobs, double a, double b, double c_from, double c_to, size_t n)
+ * @brief starts JOB_SWEEP the way the 'sweep' command does
+ * @return pointer to the started job, NULL if all slots are busy
+ */
+static Job* startSweep(JobTable *jobs, double a, double b, double c_from, double c_to, size_t n)
+{
+    char cmd[MAX_CMD_LENGHT + 1] = "";
+    snprintf(cmd, sizeof(cmd), "sweep %lg %lg %lg %lg %zu", a, b, c_from, c_to, n);
+
+    Job *job = JobTable_alloc(jobs, cmd);
+    if (!job)
+        return NULL;
+    job->kind = JOB_SWEEP;
+    job->a = a;
+    job->b = b;
+    job->c_from = c_from;
+    job->c_to = c_to;
+    job->total = n;
+    JobTable_start(jobs, job);
+    return job;
+}
+
+/**
+ * @fn static Job* startSolveFile(JobTable *jobs, const char *inPath, const char *outPath)
+ * @brief starts JOB_SOLVE_FILE the way the 'solve-file' command does
+ * @return pointer to the started job, NULL if all slots are busy
+ */
+static Job* startSolveFile(JobTable *jobs, const char *inPath, const char *outPath)
+{
+    Job *job = JobTable_alloc(jobs, "solve-file");
+    if (!job)
+        return NULL;
+    job->kind = JOB_SOLVE_FILE;
+    strncpy(job->inPath, inPath, MAX_CMD_LENGHT);
+    strncpy(job->outPath, outPath, MAX_CMD_LENGHT);
+    JobTable_start(jobs, job);
+    return job;
+}
+
+/**
+ * @fn static bool waitJob(Job *job, size_t solved = SIZE_MAX)
+ * @brief waits till the job finishes or solves at least solved equasions
+ * On timeout fails the test and cancels the job. A job ignoring the cancel would hang
+ * the join in JobTable_destruct, so then the suite exits instead.
+ * @return true if succeeds, false on timeout
+ */
+static bool waitJob(Job *job, size_t solved = SIZE_MAX)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(JOB_TIMEOUT_S);
+    while (job->state == JOB_RUNNING && job->solved < solved) {
+        if (std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ADD_FAILURE() << "job '" << job->cmd << "' did not finish in " << JOB_TIMEOUT_S << " s";
+        job->cancelRequested = true;
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (job->state == JOB_RUNNING) {
+            fflush(stdout);
+            std::_Exit(EXIT_FAILURE);
+        }
+        job->worker.join();
+        return false;
+    }
+    return true;
+}
 
 TEST(History, Manual)
 {
@@ -76,6 +146,33 @@ TEST(History, Ranges)
 }
 
 
+TEST(LogPad, Bounded)
+{
+    initscr();
+
+
+    LogPad log = {};
+
+    LogPad_construct(&log, 10, 40);
+
+    for (int i = 0; i < 2 * LOG_PAD_LINES; ++i)
+        wprintw(log.pad, "line %d\n", i);
+
+    EXPECT_EQ(getcury(log.pad), LOG_PAD_LINES - 1);
+
+    LogPad_scroll(&log, 3 * LOG_PAD_LINES);
+    EXPECT_EQ(log.scrollBack, LOG_PAD_LINES - 10);
+
+    LogPad_scroll(&log, -3 * LOG_PAD_LINES);
+    EXPECT_EQ(log.scrollBack, 0);
+
+    LogPad_destruct(&log);
+
+    clear();
+    endwin();
+}
+
+
 TEST(QuadricSolver, Manual)
 {
     double result_1 = NAN, result_2 = NAN;
@@ -94,6 +191,14 @@ TEST(QuadricSolver, Manual)
     EXPECT_FALSE(result_eq_inf);
 
 
+    result_1 = NAN, result_2 = NAN;
+    result_eq_inf = false;
+    quadricSolver(1, 0, -1, &result_1, &result_2, &result_eq_inf);        // b == 0 used to give { -inf, 0 }
+    EXPECT_DOUBLE_EQ(fmin(result_1, result_2), -1);
+    EXPECT_DOUBLE_EQ(fmax(result_1, result_2), 1);
+    EXPECT_FALSE(result_eq_inf);
+
+
     result_1 = NAN, result_2 = NAN;
     result_eq_inf = false;
     quadricSolver(14, -97, 113, &result_1, &result_2, &result_eq_inf);
@@ -136,6 +241,277 @@ TEST(QuadricSolver, Manual)
 }
 
 
+TEST(QuadricSolver, Batch)
+{
+    const double a[] = {1, 1, 14, 1400, 0, 0, 0};
+    const double b[] = {2, 0, -97, -97, -97, 0, 0};
+    const double c[] = {1, 0, 113, 113, 113, 113, 0};
+    const size_t n = sizeof(a) / sizeof(a[0]);
+
+    const double expected_1[] = {-1, 0, 1.4819, NAN, 1.1649, NAN, NAN};
+    const double expected_2[] = {-1, 0, 5.4467, NAN, 1.1649, NAN, NAN};
+    const bool expected_eq_inf[] = {false, false, false, false, false, false, true};
+
+    double result_1[n] = {}, result_2[n] = {};
+    bool result_eq_inf[n] = {};
+    quadricSolverBatch(a, b, c, result_1, result_2, result_eq_inf, n);
+
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(isnan(result_1[i]), isnan(expected_1[i]));
+        EXPECT_EQ(isnan(result_2[i]), isnan(expected_2[i]));
+        if (!isnan(expected_1[i])) {
+            EXPECT_NEAR(result_1[i], expected_1[i], TOL);
+        }
+        if (!isnan(expected_2[i])) {
+            EXPECT_NEAR(result_2[i], expected_2[i], TOL);
+        }
+        EXPECT_EQ(result_eq_inf[i], expected_eq_inf[i]);
+    }
+}
+
+
+
+TEST(QuadricSolver, Complex)
+{
+    const double a[] = {1, 1, -2, 14, 0, 0};
+    const double b[] = {2, 0, 4, -97, -97, 0};
+    const double c[] = {5, 1, -10, 113, 113, 0};
+    const size_t n = sizeof(a) / sizeof(a[0]);
+
+    double result_1[n] = {}, result_2[n] = {}, result_im[n] = {};
+    bool result_eq_inf[n] = {};
+    quadricSolverBatchComplex(a, b, c, result_1, result_2, result_im, result_eq_inf, n);
+
+    EXPECT_DOUBLE_EQ(result_1[0], -1);
+    EXPECT_DOUBLE_EQ(result_2[0], -1);
+    EXPECT_DOUBLE_EQ(result_im[0], 2);
+
+    EXPECT_DOUBLE_EQ(result_1[1], 0);
+    EXPECT_DOUBLE_EQ(result_im[1], 1);
+
+    EXPECT_DOUBLE_EQ(result_1[2], 1);
+    EXPECT_DOUBLE_EQ(result_im[2], 2);
+
+    EXPECT_NEAR(result_1[3], 1.4819, TOL);                  // real roots are the same as in quadricSolver
+    EXPECT_NEAR(result_2[3], 5.4467, TOL);
+    EXPECT_EQ(result_im[3], 0);
+
+    EXPECT_NEAR(result_1[4], 1.1649, TOL);
+    EXPECT_NEAR(result_2[4], 1.1649, TOL);
+    EXPECT_EQ(result_im[4], 0);
+
+    EXPECT_TRUE(isnan(result_1[5]));
+    EXPECT_TRUE(isnan(result_2[5]));
+    EXPECT_EQ(result_im[5], 0);
+    EXPECT_TRUE(result_eq_inf[5]);
+    for (size_t i = 0; i < n - 1; ++i)
+        EXPECT_FALSE(result_eq_inf[i]);
+}
+
+TEST(JobTable, SweepAndCancel)
+{
+    initscr();
+
+
+    LogPad log = {};
+    LogPad_construct(&log, 10, 80);
+
+    JobTable jobs;
+    JobTable_construct(&jobs, nullptr);
+
+    Job *job = startSweep(&jobs, 1, 0, -1, 1, 10001);
+    ASSERT_EQ(job, &jobs.jobs[0]);
+    ASSERT_TRUE(waitJob(job));
+
+    EXPECT_EQ(jobs.jobs[0].state, JOB_DONE);
+    EXPECT_EQ(jobs.jobs[0].solved, 10001u);
+    EXPECT_EQ(jobs.jobs[0].rootsCount[0] + jobs.jobs[0].rootsCount[1] + jobs.jobs[0].rootsCount[2], 10001u);
+    EXPECT_GT(jobs.jobs[0].rootsCount[0], 0u);
+    EXPECT_GT(jobs.jobs[0].rootsCount[2], 0u);
+
+    JobTable_poll(&jobs, &log);
+    EXPECT_EQ(jobs.jobs[0].state, JOB_FREE);
+
+    job = startSweep(&jobs, 1, 0, -1, 1, 1000000000000);
+    ASSERT_EQ(job, &jobs.jobs[0]);
+
+    EXPECT_TRUE(JobTable_cancel(&jobs, 0));
+    ASSERT_TRUE(waitJob(job));
+
+    EXPECT_EQ(jobs.jobs[0].state, JOB_CANCELLED);
+    EXPECT_LT(jobs.jobs[0].solved, 1000000000000u);
+
+    JobTable_poll(&jobs, &log);
+    EXPECT_EQ(jobs.jobs[0].state, JOB_FREE);
+    EXPECT_FALSE(JobTable_cancel(&jobs, 0));
+
+    JobTable_destruct(&jobs);
+    LogPad_destruct(&log);
+
+    clear();
+    endwin();
+}
+
+
+
+TEST(PipeQueue, Bounded)
+{
+    PipeQueue queue;
+    PipeQueue_construct(&queue);
+
+    PipeChunk *chunks = (PipeChunk *)calloc(PIPE_CHUNKS, sizeof(PipeChunk));
+    ASSERT_NE(chunks, nullptr);
+
+    EXPECT_EQ(PipeQueue_pop(&queue), nullptr);
+    for (size_t i = 0; i < PIPE_CHUNKS; ++i)
+        EXPECT_TRUE(PipeQueue_push(&queue, &chunks[i]));
+    EXPECT_FALSE(PipeQueue_push(&queue, &chunks[0]));
+
+    for (size_t i = 0; i < PIPE_CHUNKS; ++i)
+        EXPECT_EQ(PipeQueue_pop(&queue), &chunks[i]);
+    EXPECT_EQ(PipeQueue_pop(&queue), nullptr);
+
+    free(chunks);
+}
+
+
+TEST(Pipeline, SolveFile)
+{
+    const char *inPath  = "test-qs-solve-file-in.txt";          // own files, ctest -j runs tests in parallel
+    const char *outPath = "test-qs-solve-file-out.txt";
+    const size_t n = 100000;                // several PIPE_CHUNK_BYTES of input
+
+    FILE *in = fopen(inPath, "w");
+    ASSERT_NE(in, nullptr);
+    for (size_t i = 0; i < n; ++i)
+        fprintf(in, "%lg %lg %lg\n", (double)(i % 7) - 3, (double)(i % 11) - 5, (double)(i % 13) - 6);
+    fclose(in);
+
+    JobTable jobs;
+    JobTable_construct(&jobs, nullptr);
+
+    Job *job = startSolveFile(&jobs, inPath, outPath);
+    ASSERT_EQ(job, &jobs.jobs[0]);
+    ASSERT_TRUE(waitJob(job));
+
+    EXPECT_EQ(jobs.jobs[0].state, JOB_DONE);
+    EXPECT_EQ(jobs.jobs[0].solved, n);
+    EXPECT_EQ(jobs.jobs[0].processed, jobs.jobs[0].total);
+
+    FILE *out = fopen(outPath, "r");
+    ASSERT_NE(out, nullptr);
+    char line[128] = "", expected[128] = "";
+    size_t lines = 0;
+    while (fgets(line, sizeof(line), out)) {
+        double a = (double)(lines % 7) - 3, b = (double)(lines % 11) - 5, c = (double)(lines % 13) - 6;
+        double result_1 = NAN, result_2 = NAN;
+        bool result_eq_inf = false;
+        quadricSolverBatch(&a, &b, &c, &result_1, &result_2, &result_eq_inf, 1);
+        snprintf(expected, sizeof(expected), "%lg %lg %d\n", result_1, result_2, result_eq_inf);
+        EXPECT_STREQ(line, expected);
+        ++lines;
+    }
+    fclose(out);
+    EXPECT_EQ(lines, n);
+
+    in = fopen(inPath, "w");
+    ASSERT_NE(in, nullptr);
+    fprintf(in, "1 2 1\n1 two 1\n");
+    fclose(in);
+
+    job = startSolveFile(&jobs, inPath, outPath);
+    ASSERT_EQ(job, &jobs.jobs[1]);
+    ASSERT_TRUE(waitJob(job));
+
+    EXPECT_EQ(jobs.jobs[1].state, JOB_FAILED);
+
+    JobTable_destruct(&jobs);
+    remove(inPath);
+    remove(outPath);
+}
+
+
+TEST(Pipeline, Cancel)
+{
+    const char *inPath  = "test-qs-cancel-in.txt";
+    const char *outPath = "test-qs-cancel-out.txt";
+    const size_t n = 500000;                // enough input to be cancelled in the middle
+
+    FILE *in = fopen(inPath, "w");
+    ASSERT_NE(in, nullptr);
+    for (size_t i = 0; i < n; ++i)
+        fprintf(in, "%lg %lg %lg\n", (double)(i % 7) - 3, (double)(i % 11) - 5, (double)(i % 13) - 6);
+    fclose(in);
+
+    JobTable jobs;
+    JobTable_construct(&jobs, nullptr);
+
+    Job *job = startSolveFile(&jobs, inPath, outPath);
+    ASSERT_EQ(job, &jobs.jobs[0]);
+    ASSERT_TRUE(waitJob(job, 1));
+
+    EXPECT_TRUE(JobTable_cancel(&jobs, 0));
+    ASSERT_TRUE(waitJob(job));
+
+    EXPECT_EQ(job->state, JOB_CANCELLED);
+    EXPECT_LT(job->solved, n);
+    EXPECT_FALSE(JobTable_cancel(&jobs, 0));
+
+    FILE *out = fopen(outPath, "r");                // chunks popped after cancel are dropped, not written
+    ASSERT_NE(out, nullptr);
+    char line[128] = "";
+    size_t lines = 0;
+    while (fgets(line, sizeof(line), out))
+        ++lines;
+    fclose(out);
+    EXPECT_LE(lines, job->solved);
+
+    JobTable_destruct(&jobs);
+    remove(inPath);
+    remove(outPath);
+}
+
+TEST(BatchBuffer, Sources)
+{
+    int modes[] = {BATCH_ALLOC_DEFAULT, BATCH_ALLOC_HUGE, BATCH_ALLOC_HUGE | BATCH_ALLOC_NUMA};
+    for (int flags : modes) {
+        BatchBuffer buf = {};
+        ASSERT_TRUE(BatchBuffer_construct(&buf, 3 * HUGE_PAGE_SIZE + 1, flags));
+        ASSERT_NE(buf.data, nullptr);
+        EXPECT_GE(buf.size, 3 * HUGE_PAGE_SIZE + 1);
+        if (flags == BATCH_ALLOC_DEFAULT) {
+            EXPECT_EQ(buf.source, BATCH_BUF_CALLOC);
+        }
+        else if (buf.source != BATCH_BUF_CALLOC) {                       // no huge pages without Linux
+            EXPECT_EQ((uintptr_t)buf.data % HUGE_PAGE_SIZE, 0u);
+        }
+#ifdef __linux__
+        if (buf.source == BATCH_BUF_THP) {                               // reported only if the kernel used them
+            EXPECT_GT(BatchBuffer_hugeBytes(buf.data), 0u);
+        }
+#endif
+
+        unsigned char *bytes = (unsigned char *)buf.data;
+        for (size_t i = 0; i < 3 * HUGE_PAGE_SIZE + 1; i += 4096)
+            ASSERT_EQ(bytes[i], 0);
+        bytes[3 * HUGE_PAGE_SIZE] = 1;
+
+        BatchBuffer_destruct(&buf);
+    }
+
+    JobTable jobs;
+    JobTable_construct(&jobs, NULL);
+    jobs.allocFlags = BATCH_ALLOC_HUGE | BATCH_ALLOC_NUMA;
+    Job *job = startSweep(&jobs, 1, 0, -1, 1, 100000);
+    ASSERT_NE(job, nullptr);
+    ASSERT_TRUE(waitJob(job));
+
+    EXPECT_EQ(job->state, JOB_DONE);
+    EXPECT_NE(job->bufSource, -1);
+    EXPECT_EQ(job->rootsCount[0] + job->rootsCount[1] + job->rootsCount[2], 100000u);
+    JobTable_destruct(&jobs);
+}
+
 /*
 TEST(QuadricSolver, Ranges)         //TODO add Ranged tests 
 {